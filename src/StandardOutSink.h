@@ -2,6 +2,7 @@
 #include <string>
 #include <iostream>
 #include <iomanip>
+#include <mutex>
 
 #if WIN32
 #define WIN32_MEAN_AND_LEAN
@@ -1,51 +1,23 @@
-#include "Hello.h"
+#include "hello.h"
 
 #include <g3log/g3log.hpp>
 #include "cgr_error.h"
-#define GLFW_EXPOSE_NATIVE_WIN32
-#include <GLFW/glfw3native.h>
 
 #include <DebugOutput.h>
 #include <SwapChain.h>
-#if VULKAN_SUPPORTED
-#include <EngineFactoryVk.h>
-#endif
 #include <MapHelper.hpp>
 
-constexpr int kWindowWidth             = 800;
-constexpr int kWindowHeight            = 600;
-constexpr int kDiligentValidationLevel = -1;
-
-
-static void FramebufferResizeCallback(GLFWwindow* window, int width, int height)
-{
-    auto app = static_cast<HelloDiligent*>(glfwGetWindowUserPointer(window));
-    if (app && app->swap_chain_)
-        app->swap_chain_->Resize(static_cast<Diligent::Uint32>(width), static_cast<Diligent::Uint32>(height));
-}
-
-
-void HelloDiligent::InitWindow()
-{
-    if (glfwInit() != GLFW_TRUE)
-        throw CGR_FAIL("Could not initialize GLFW!");
-
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-
-    window_ = glfwCreateWindow(kWindowWidth, kWindowHeight, "Hello-Diligent", nullptr, nullptr);
-    if (window_ == nullptr)
-        throw CGR_FAIL("Could not create GLFW window!");
+#include <iterator>
+#include <vector>
 
-    glfwSetWindowUserPointer(window_, this);
-    glfwSetFramebufferSizeCallback(window_, FramebufferResizeCallback);
-}
+constexpr int kDiligentValidationLevel = -1;
 
 
-void __cdecl MyDebugMessageCallback(enum Diligent::DEBUG_MESSAGE_SEVERITY severity,
-                                    const Diligent::Char*                 message,
-                                    const Diligent::Char*                 function,
-                                    const Diligent::Char*                 file,
-                                    int                                   line)
+void DILIGENT_CALL_TYPE MyDebugMessageCallback(enum Diligent::DEBUG_MESSAGE_SEVERITY severity,
+                                               const Diligent::Char*                 message,
+                                               const Diligent::Char*                 function,
+                                               const Diligent::Char*                 file,
+                                               int                                   line)
 {
     if (message == nullptr)
         return;
@@ -74,34 +46,114 @@ void __cdecl MyDebugMessageCallback(enum Diligent::DEBUG_MESSAGE_SEVERITY severi
 }
 
 
-void HelloDiligent::InitDiligent()
+static Diligent::IEngineFactoryVk* GetEngineFactory()
 {
-    Diligent::Win32NativeWindow window{ glfwGetWin32Window(window_) };
-    Diligent::SwapChainDesc     swap_chain_desc;
-
 #if EXPLICITLY_LOAD_ENGINE_VK_DLL
     auto* GetEngineFactoryVk = Diligent::LoadGraphicsEngineVk();
     if (GetEngineFactoryVk == nullptr)
         throw CGR_FAIL("Could not load Diligent graphics engine!");
 #endif
+    auto* factory_vk = GetEngineFactoryVk();
+    factory_vk->SetMessageCallback(MyDebugMessageCallback);
+    return factory_vk;
+}
+
+
+static Diligent::EngineVkCreateInfo GetEngineCreateInfo()
+{
     Diligent::EngineVkCreateInfo engine_ci;
 
     if constexpr (kDiligentValidationLevel >= 0)
         engine_ci.SetValidationLevel(static_cast<Diligent::VALIDATION_LEVEL>(kDiligentValidationLevel));
 
     engine_ci.DynamicHeapSize = 256 << 20;
+    return engine_ci;
+}
 
-    auto* factory_vk = GetEngineFactoryVk();
-    factory_vk->SetMessageCallback(MyDebugMessageCallback);
-    factory_vk->CreateDeviceAndContextsVk(engine_ci, &device_, &device_context_);
-    factory_vk->CreateSwapChainVk(device_, device_context_, swap_chain_desc, window, &swap_chain_);
-    engine_factory_ = factory_vk;
 
-    if (device_ == nullptr || device_context_ == nullptr || swap_chain_ == nullptr)
+void HelloDiligent::InitDevice(const Diligent::Uint32 adapter_id)
+{
+    Diligent::EngineVkCreateInfo engine_ci = GetEngineCreateInfo();
+    engine_ci.AdapterId                    = adapter_id;
+
+    engine_factory_ = GetEngineFactory();
+    engine_factory_->CreateDeviceAndContextsVk(engine_ci, &device_, &device_context_);
+
+    if (device_ == nullptr || device_context_ == nullptr)
         throw CGR_FAIL("Could not initialize Diligent engine!");
 }
 
 
+void HelloDiligent::InitDiligentHeadless(const Diligent::Uint32 width,
+                                         const Diligent::Uint32 height,
+                                         const bool             require_software_adapter)
+{
+    const Diligent::Version api_version = GetEngineCreateInfo().GraphicsAPIVersion;
+
+    auto* factory_vk = GetEngineFactory();
+
+    // prefer a software adapter (e.g. lavapipe or SwiftShader) so results do not depend on the GPU
+    Diligent::Uint32 num_adapters = 0;
+    factory_vk->EnumerateAdapters(api_version, num_adapters, nullptr);
+    std::vector<Diligent::GraphicsAdapterInfo> adapters(num_adapters);
+    if (num_adapters > 0)
+        factory_vk->EnumerateAdapters(api_version, num_adapters, adapters.data());
+    if (num_adapters == 0)
+        throw CGR_FAIL("No Vulkan adapter found!");
+
+    Diligent::Uint32 adapter_id = 0;
+    for (Diligent::Uint32 i = 0; i < num_adapters; ++i)
+    {
+        if (adapters[i].Type == Diligent::ADAPTER_TYPE_SOFTWARE)
+        {
+            adapter_id = i;
+            break;
+        }
+    }
+
+    const auto& adapter = adapters[adapter_id];
+    if (adapter.Type == Diligent::ADAPTER_TYPE_SOFTWARE)
+        LOG(INFO) << "Using software adapter: " << adapter.Description;
+    else if (require_software_adapter)
+        throw CGR_FAIL(std::string("No software Vulkan adapter found, refusing to run on: ") + adapter.Description);
+    else
+        LOG(WARNING) << "No software Vulkan adapter found, results depend on the hardware adapter: "
+                     << adapter.Description;
+
+    InitDevice(adapter_id);
+
+    // the offscreen targets mirror the formats of a default swap chain so the same PSO works for both paths
+    offscreen_desc_.Width        = width;
+    offscreen_desc_.Height       = height;
+    offscreen_desc_.PreTransform = Diligent::SURFACE_TRANSFORM_IDENTITY;
+
+    Diligent::TextureDesc color_desc;
+    color_desc.Name      = "Offscreen color buffer";
+    color_desc.Type      = Diligent::RESOURCE_DIM_TEX_2D;
+    color_desc.Width     = width;
+    color_desc.Height    = height;
+    color_desc.Format    = offscreen_desc_.ColorBufferFormat;
+    color_desc.BindFlags = Diligent::BIND_RENDER_TARGET;
+    device_->CreateTexture(color_desc, nullptr, &offscreen_color_);
+    if (offscreen_color_ == nullptr)
+        throw CGR_FAIL("Could not create offscreen color buffer!");
+
+    Diligent::TextureDesc depth_desc = color_desc;
+    depth_desc.Name      = "Offscreen depth buffer";
+    depth_desc.Format    = offscreen_desc_.DepthBufferFormat;
+    depth_desc.BindFlags = Diligent::BIND_DEPTH_STENCIL;
+    device_->CreateTexture(depth_desc, nullptr, &offscreen_depth_);
+    if (offscreen_depth_ == nullptr)
+        throw CGR_FAIL("Could not create offscreen depth buffer!");
+}
+
+
+const Diligent::SwapChainDesc& HelloDiligent::GetSurfaceDesc() const
+{
+    return swap_chain_ ? swap_chain_->GetDesc() : offscreen_desc_;
+}
+
+
 void HelloDiligent::CreatePipelineState()
 {
     Diligent::GraphicsPipelineStateCreateInfo pso_ci;
@@ -110,8 +162,8 @@ void HelloDiligent::CreatePipelineState()
     pso_ci.PSODesc.PipelineType = Diligent::PIPELINE_TYPE_GRAPHICS;
 
     pso_ci.GraphicsPipeline.NumRenderTargets             = 1;
-    pso_ci.GraphicsPipeline.RTVFormats[0]                = swap_chain_->GetDesc().ColorBufferFormat;
-    pso_ci.GraphicsPipeline.DSVFormat                    = swap_chain_->GetDesc().DepthBufferFormat;
+    pso_ci.GraphicsPipeline.RTVFormats[0]                = GetSurfaceDesc().ColorBufferFormat;
+    pso_ci.GraphicsPipeline.DSVFormat                    = GetSurfaceDesc().DepthBufferFormat;
     pso_ci.GraphicsPipeline.PrimitiveTopology            = Diligent::PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
     pso_ci.GraphicsPipeline.RasterizerDesc.CullMode      = Diligent::CULL_MODE_BACK;
     pso_ci.GraphicsPipeline.DepthStencilDesc.DepthEnable = true;
@@ -164,7 +216,7 @@ void HelloDiligent::CreatePipelineState()
                                                   Diligent::LayoutElement{ 1, 0, 4, Diligent::VT_FLOAT32, false } };
 
     pso_ci.GraphicsPipeline.InputLayout.LayoutElements = layout_elements;
-    pso_ci.GraphicsPipeline.InputLayout.NumElements    = _countof(layout_elements);
+    pso_ci.GraphicsPipeline.InputLayout.NumElements    = static_cast<Diligent::Uint32>(std::size(layout_elements));
 
     pso_ci.pVS = vertex_shader;
     pso_ci.pPS = pixel_shader;
@@ -253,7 +305,7 @@ void HelloDiligent::CreateIndexBuffer()
 
 Diligent::float4x4 HelloDiligent::GetSurfacePretransformMatrix(const Diligent::float3& camera_view_axis) const
 {
-    const auto& swap_chain_desc = swap_chain_->GetDesc();
+    const auto& swap_chain_desc = GetSurfaceDesc();
     switch (swap_chain_desc.PreTransform)
     {
         case Diligent::SURFACE_TRANSFORM_ROTATE_90:
@@ -287,7 +339,7 @@ Diligent::float4x4 HelloDiligent::GetSurfacePretransformMatrix(const Diligent::f
 
 Diligent::float4x4 HelloDiligent::GetAdjustedProjectionMatrix(float fov, float near_plane, float far_plane) const
 {
-    const auto& swap_chain_desc = swap_chain_->GetDesc();
+    const auto& swap_chain_desc = GetSurfaceDesc();
 
     float aspect_ratio = static_cast<float>(swap_chain_desc.Width) / static_cast<float>(swap_chain_desc.Height);
     float x_scale, y_scale;
@@ -333,9 +385,25 @@ void HelloDiligent::Update(const TimeValueType current_time, const TimeValueType
 
 void HelloDiligent::Draw()
 {
-    auto*       render_target_view = swap_chain_->GetCurrentBackBufferRTV();
-    auto*       depth_stencil_view = swap_chain_->GetDepthBufferDSV();
+    Render(swap_chain_->GetCurrentBackBufferRTV(), swap_chain_->GetDepthBufferDSV());
+    swap_chain_->Present();
+}
+
+
+void HelloDiligent::DrawOffscreen()
+{
+    Render(offscreen_color_->GetDefaultView(Diligent::TEXTURE_VIEW_RENDER_TARGET),
+           offscreen_depth_->GetDefaultView(Diligent::TEXTURE_VIEW_DEPTH_STENCIL));
+
+    // without a swap chain nobody calls Present(), so the frame has to be finished explicitly
+    device_context_->Flush();
+    device_context_->FinishFrame();
+    device_->ReleaseStaleResources();
+}
 
+
+void HelloDiligent::Render(Diligent::ITextureView* render_target_view, Diligent::ITextureView* depth_stencil_view)
+{
     device_context_->SetRenderTargets(1, &render_target_view, depth_stencil_view,
                                       Diligent::RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
 
@@ -373,36 +441,6 @@ void HelloDiligent::Draw()
     // Verify the state of vertex and index buffers
     draw_attributes.Flags      = Diligent::DRAW_FLAG_VERIFY_ALL;
     device_context_->DrawIndexed(draw_attributes);
-
-    swap_chain_->Present();
-}
-
-
-int HelloDiligent::MainLoop()
-{
-    last_update_ = Clock::now();
-    while (true)
-    {
-        if (glfwWindowShouldClose(window_))
-            break;
-
-        glfwPollEvents();
-
-        const auto time       = Clock::now();
-        const auto delta_time = std::chrono::duration_cast<TimeUnitType>(time - last_update_).count();
-        last_update_          = time;
-
-        auto time_usec = std::chrono::duration_cast<TimeUnitType>(time.time_since_epoch()).count();
-        Update(time_usec, delta_time);
-
-        int width, height;
-        glfwGetWindowSize(window_, &width, &height);
-
-        if (width > 0 && height > 0)
-            Draw();
-    }
-
-    return 0;
 }
 
 
@@ -412,12 +450,3 @@ void HelloDiligent::Initialize()
     CreateVertexBuffer();
     CreateIndexBuffer();
 }
-
-
-int HelloDiligent::Run()
-{
-    InitWindow();
-    InitDiligent();
-    Initialize();
-    return MainLoop();
-}
@@ -2,16 +2,15 @@
 
 #include <chrono>
 
-// #define GLFW_INCLUDE_VULKAN
-#include <GLFW/glfw3.h>
-
-#include <EngineFactory.h>
+#include <EngineFactoryVk.h>
 #include <RenderDevice.h>
 #include <DeviceContext.h>
 #include <SwapChain.h>
 #include <RefCntAutoPtr.hpp>
 #include <BasicMath.hpp>
 
+struct GLFWwindow;
+
 class HelloDiligent
 {
 public:
@@ -22,6 +21,8 @@ public:
 public:
     void InitWindow();
     void InitDiligent();
+    void InitDevice(Diligent::Uint32 adapter_id = Diligent::DEFAULT_ADAPTER_ID);
+    void InitDiligentHeadless(Diligent::Uint32 width, Diligent::Uint32 height, bool require_software_adapter = false);
     void Initialize();
     void CreatePipelineState();
     void CreateVertexBuffer();
@@ -30,18 +31,22 @@ public:
     int  MainLoop();
     void Update(TimeValueType current_time, TimeValueType delta_time);
     void Draw();
+    void DrawOffscreen();
+    void Render(Diligent::ITextureView* render_target_view, Diligent::ITextureView* depth_stencil_view);
+
+    const Diligent::SwapChainDesc& GetSurfaceDesc() const;
 
 private:
     Diligent::float4x4 GetSurfacePretransformMatrix(const Diligent::float3& camera_view_axis) const;
     Diligent::float4x4 GetAdjustedProjectionMatrix(float fov, float near_plane, float far_plane) const;
 
 public:
-    GLFWwindow*               window_         = nullptr;
-    Diligent::IEngineFactory* engine_factory_ = nullptr;
-    Diligent::IRenderDevice*  device_         = nullptr;
-    Diligent::IDeviceContext* device_context_ = nullptr;
-    Diligent::ISwapChain*     swap_chain_     = nullptr;
-    Clock::time_point         last_update_    = {};
+    GLFWwindow*                 window_         = nullptr;
+    Diligent::IEngineFactoryVk* engine_factory_ = nullptr;
+    Diligent::IRenderDevice*    device_         = nullptr;
+    Diligent::IDeviceContext*   device_context_ = nullptr;
+    Diligent::ISwapChain*       swap_chain_     = nullptr;
+    Clock::time_point           last_update_    = {};
 
     Diligent::RefCntAutoPtr<Diligent::IPipelineState>         pso_;
     Diligent::RefCntAutoPtr<Diligent::IShaderResourceBinding> shader_resource_binding_;
@@ -49,4 +54,9 @@ public:
     Diligent::RefCntAutoPtr<Diligent::IBuffer>                cube_vertex_buffer_;
     Diligent::RefCntAutoPtr<Diligent::IBuffer>                cube_index_buffer_;
     Diligent::float4x4                                        world_view_projection_matrix_;
+
+    // offscreen render targets used instead of the swap chain when running headless
+    Diligent::RefCntAutoPtr<Diligent::ITexture> offscreen_color_;
+    Diligent::RefCntAutoPtr<Diligent::ITexture> offscreen_depth_;
+    Diligent::SwapChainDesc                     offscreen_desc_;
 };
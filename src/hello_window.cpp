@@ -0,0 +1,87 @@
+#include "hello.h"
+
+#include "cgr_error.h"
+
+#include <GLFW/glfw3.h>
+#define GLFW_EXPOSE_NATIVE_WIN32
+#include <GLFW/glfw3native.h>
+
+// Window and swap chain handling of the interactive application. Everything else lives in hello.cpp so it can be
+// shared with the headless tests, which must not depend on GLFW or the Win32 window system.
+
+constexpr int kWindowWidth  = 800;
+constexpr int kWindowHeight = 600;
+
+
+static void FramebufferResizeCallback(GLFWwindow* window, int width, int height)
+{
+    auto app = static_cast<HelloDiligent*>(glfwGetWindowUserPointer(window));
+    if (app && app->swap_chain_)
+        app->swap_chain_->Resize(static_cast<Diligent::Uint32>(width), static_cast<Diligent::Uint32>(height));
+}
+
+
+void HelloDiligent::InitWindow()
+{
+    if (glfwInit() != GLFW_TRUE)
+        throw CGR_FAIL("Could not initialize GLFW!");
+
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+
+    window_ = glfwCreateWindow(kWindowWidth, kWindowHeight, "Hello-Diligent", nullptr, nullptr);
+    if (window_ == nullptr)
+        throw CGR_FAIL("Could not create GLFW window!");
+
+    glfwSetWindowUserPointer(window_, this);
+    glfwSetFramebufferSizeCallback(window_, FramebufferResizeCallback);
+}
+
+
+void HelloDiligent::InitDiligent()
+{
+    Diligent::Win32NativeWindow window{ glfwGetWin32Window(window_) };
+    Diligent::SwapChainDesc     swap_chain_desc;
+
+    InitDevice();
+    engine_factory_->CreateSwapChainVk(device_, device_context_, swap_chain_desc, window, &swap_chain_);
+
+    if (swap_chain_ == nullptr)
+        throw CGR_FAIL("Could not create swap chain!");
+}
+
+
+int HelloDiligent::MainLoop()
+{
+    last_update_ = Clock::now();
+    while (true)
+    {
+        if (glfwWindowShouldClose(window_))
+            break;
+
+        glfwPollEvents();
+
+        const auto time       = Clock::now();
+        const auto delta_time = std::chrono::duration_cast<TimeUnitType>(time - last_update_).count();
+        last_update_          = time;
+
+        auto time_usec = std::chrono::duration_cast<TimeUnitType>(time.time_since_epoch()).count();
+        Update(time_usec, delta_time);
+
+        int width, height;
+        glfwGetWindowSize(window_, &width, &height);
+
+        if (width > 0 && height > 0)
+            Draw();
+    }
+
+    return 0;
+}
+
+
+int HelloDiligent::Run()
+{
+    InitWindow();
+    InitDiligent();
+    Initialize();
+    return MainLoop();
+}
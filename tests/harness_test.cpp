@@ -0,0 +1,189 @@
+// Unit tests for the pieces of the render test harness that decide whether a run passes: PPM round trip, image
+// comparison, frame time statistics, thresholds and baseline lookups. Needs neither a device nor a window.
+
+#include "image_compare.h"
+#include "json_utils.h"
+#include "perf_report.h"
+
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static int g_failures = 0;
+
+#define CHECK(condition)                                                                   \
+    do                                                                                     \
+    {                                                                                      \
+        if (!(condition))                                                                  \
+        {                                                                                  \
+            std::cout << __FILE__ << ':' << __LINE__ << ": CHECK(" #condition ") failed\n"; \
+            ++g_failures;                                                                  \
+        }                                                                                  \
+    } while (false)
+
+static bool Near(double a, double b)
+{
+    return std::abs(a - b) < 1e-9;
+}
+
+
+static void TestPPMRoundTrip(const std::string& temp_dir)
+{
+    cgr::Image image(3, 2);
+    for (size_t i = 0; i < image.pixels.size(); ++i)
+        image.pixels[i] = static_cast<uint8_t>(i * 13);
+
+    const std::string path = temp_dir + "/harness_roundtrip.ppm";
+    cgr::WritePPM(path, image);
+    cgr::Image loaded = cgr::ReadPPM(path);
+    std::remove(path.c_str());
+
+    CHECK(loaded.width == 3);
+    CHECK(loaded.height == 2);
+    CHECK(loaded.pixels == image.pixels);
+}
+
+
+static void TestCompareImagesTolerance()
+{
+    cgr::Image reference(4, 1);
+    cgr::Image actual(4, 1);
+    for (uint32_t x = 0; x < 4; ++x)
+    {
+        reference.At(x, 0)[0] = 100;
+        actual.At(x, 0)[0]    = 100;
+    }
+    actual.At(1, 0)[0] = 102; // exactly at the tolerance
+    actual.At(2, 0)[1] = 3;   // one above the tolerance in another channel
+
+    auto result = cgr::CompareImages(reference, actual, 2);
+    CHECK(result.mismatched_pixels == 1);
+    CHECK(result.max_channel_delta == 3);
+    CHECK(Near(result.mismatch_ratio, 0.25));
+    CHECK(result.diff.At(2, 0)[0] == 255 && result.diff.At(2, 0)[1] == 0);
+    CHECK(result.diff.At(1, 0)[0] == 25);
+
+    auto exact = cgr::CompareImages(reference, reference, 0);
+    CHECK(exact.mismatched_pixels == 0);
+
+    bool threw = false;
+    try
+    {
+        cgr::CompareImages(reference, cgr::Image(2, 2), 2);
+    }
+    catch (const cgrebel::Error&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+
+static void TestFrameTimeStats()
+{
+    std::vector<double> samples;
+    for (int i = 20; i >= 1; --i)
+        samples.push_back(static_cast<double>(i));
+
+    auto stats = cgr::FrameTimeStats::FromSamples(samples);
+    CHECK(Near(stats.mean_ms, 10.5));
+    CHECK(Near(stats.median_ms, 10.0));
+    CHECK(Near(stats.p95_ms, 19.0));
+    CHECK(Near(stats.min_ms, 1.0));
+    CHECK(Near(stats.max_ms, 20.0));
+
+    auto single = cgr::FrameTimeStats::FromSamples({ 7.0 });
+    CHECK(Near(single.median_ms, 7.0));
+    CHECK(Near(single.p95_ms, 7.0));
+}
+
+
+static void TestThresholds()
+{
+    CHECK((cgr::PerfThreshold{ "a", 10.0, 10.0, true }.Passed()));
+    CHECK(!(cgr::PerfThreshold{ "a", 10.0, 10.5, true }.Passed()));
+    CHECK((cgr::PerfThreshold{ "a", 10.0, 10.0, false }.Passed()));
+    CHECK(!(cgr::PerfThreshold{ "a", 10.0, 9.5, false }.Passed()));
+
+    cgr::PerfReport report;
+    CHECK(report.Passed()); // no thresholds configured
+}
+
+
+static void TestBaselineRoundTrip(const std::string& temp_dir)
+{
+    cgr::PerfReport baseline;
+    baseline.scene          = "cube";
+    baseline.adapter        = "llvmpipe \"test\"";
+    baseline.frame_time     = cgr::FrameTimeStats::FromSamples({ 2.0, 2.0, 4.0 });
+    baseline.throughput_fps = 500.0;
+    baseline.thresholds.push_back({ "throughput_fps", 1.0, 500.0, false });
+
+    const std::string path = temp_dir + "/harness_baseline.json";
+    baseline.WriteJson(path);
+    auto json = cgr::ReadTextFile(path);
+    std::remove(path.c_str());
+    CHECK(json.has_value());
+    if (!json)
+        return;
+
+    CHECK(cgr::FindJsonString(*json, "adapter") == baseline.adapter);
+    CHECK(Near(cgr::FindJsonNumber(*json, "throughput_fps").value_or(0.0), 500.0));
+    CHECK(!cgr::FindJsonNumber(*json, "missing").has_value());
+
+    // clearly inside the 10% limit passes, clearly outside fails; exact boundary values would depend on the
+    // precision WriteJson prints with
+    cgr::PerfReport within;
+    within.frame_time.mean_ms = baseline.frame_time.mean_ms * 1.09;
+    within.frame_time.p95_ms  = baseline.frame_time.p95_ms * 1.09;
+    within.throughput_fps     = 500.0 / 1.09;
+    CHECK(within.AddBaselineThresholds(*json, 10.0) == baseline.adapter);
+    CHECK(within.thresholds.size() == 3);
+    CHECK(within.Passed());
+
+    cgr::PerfReport slower = within;
+    slower.thresholds.clear();
+    slower.frame_time.mean_ms = baseline.frame_time.mean_ms * 1.11;
+    slower.AddBaselineThresholds(*json, 10.0);
+    CHECK(!slower.Passed());
+
+    cgr::PerfReport lower_fps = within;
+    lower_fps.thresholds.clear();
+    lower_fps.throughput_fps = 500.0 / 1.11;
+    lower_fps.AddBaselineThresholds(*json, 10.0);
+    CHECK(!lower_fps.Passed());
+}
+
+
+int main(int argc, char* argv[])
+{
+    const std::string temp_dir = argc > 1 ? argv[1] : ".";
+
+    const std::vector<std::pair<const char*, std::function<void()>>> tests = {
+        { "PPMRoundTrip", [&] { TestPPMRoundTrip(temp_dir); } },
+        { "CompareImagesTolerance", TestCompareImagesTolerance },
+        { "FrameTimeStats", TestFrameTimeStats },
+        { "Thresholds", TestThresholds },
+        { "BaselineRoundTrip", [&] { TestBaselineRoundTrip(temp_dir); } },
+    };
+
+    for (const auto& [name, test] : tests)
+    {
+        const int failures_before = g_failures;
+        try
+        {
+            test();
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << name << ": unexpected exception: " << e.what() << '\n';
+            ++g_failures;
+        }
+        std::cout << (g_failures == failures_before ? "[PASS] " : "[FAIL] ") << name << '\n';
+    }
+
+    return g_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "cgr_error.h"
+
+namespace cgr {
+
+// tightly packed 8-bit RGB image, stored on disk as binary PPM (P6) so no image library is required
+struct Image
+{
+    uint32_t             width  = 0;
+    uint32_t             height = 0;
+    std::vector<uint8_t> pixels = {};
+
+    Image() = default;
+    Image(uint32_t width_, uint32_t height_)
+        : width(width_)
+        , height(height_)
+        , pixels(static_cast<size_t>(width_) * height_ * 3, 0)
+    {}
+
+    uint8_t*       At(uint32_t x, uint32_t y) { return &pixels[(static_cast<size_t>(y) * width + x) * 3]; }
+    const uint8_t* At(uint32_t x, uint32_t y) const { return &pixels[(static_cast<size_t>(y) * width + x) * 3]; }
+};
+
+struct ImageCompareResult
+{
+    uint32_t mismatched_pixels = 0;
+    uint32_t max_channel_delta = 0;
+    double   mismatch_ratio    = 0.0;
+    Image    diff;
+};
+
+
+inline Image ReadPPM(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw CGR_FAIL("Could not open image '" + path + "'!");
+
+    std::string magic;
+    uint32_t    width = 0, height = 0, max_value = 0;
+    file >> magic >> width >> height >> max_value;
+    file.get(); // single whitespace between header and pixel data
+
+    if (magic != "P6" || max_value != 255 || width == 0 || height == 0)
+        throw CGR_FAIL("Unsupported image format in '" + path + "'!");
+
+    Image image(width, height);
+    file.read(reinterpret_cast<char*>(image.pixels.data()), static_cast<std::streamsize>(image.pixels.size()));
+    if (!file)
+        throw CGR_FAIL("Image '" + path + "' is truncated!");
+
+    return image;
+}
+
+
+inline void WritePPM(const std::string& path, const Image& image)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        throw CGR_FAIL("Could not write image '" + path + "'!");
+
+    file << "P6\n" << image.width << ' ' << image.height << "\n255\n";
+    file.write(reinterpret_cast<const char*>(image.pixels.data()), static_cast<std::streamsize>(image.pixels.size()));
+}
+
+
+// A pixel counts as mismatched if any channel differs by more than channel_tolerance.
+// The diff image highlights mismatched pixels in red on top of a darkened copy of the reference.
+inline ImageCompareResult CompareImages(const Image& reference, const Image& actual, uint32_t channel_tolerance)
+{
+    if (reference.width != actual.width || reference.height != actual.height)
+        throw CGR_FAIL("Image sizes differ: " + std::to_string(reference.width) + "x" +
+                       std::to_string(reference.height) + " vs " + std::to_string(actual.width) + "x" +
+                       std::to_string(actual.height));
+
+    ImageCompareResult result;
+    result.diff = Image(reference.width, reference.height);
+
+    for (uint32_t y = 0; y < reference.height; ++y)
+    {
+        for (uint32_t x = 0; x < reference.width; ++x)
+        {
+            const uint8_t* expected = reference.At(x, y);
+            const uint8_t* got      = actual.At(x, y);
+            uint8_t*       diff     = result.diff.At(x, y);
+
+            uint32_t delta = 0;
+            for (int c = 0; c < 3; ++c)
+                delta = std::max(delta, static_cast<uint32_t>(std::abs(int(expected[c]) - int(got[c]))));
+
+            result.max_channel_delta = std::max(result.max_channel_delta, delta);
+            if (delta > channel_tolerance)
+            {
+                ++result.mismatched_pixels;
+                diff[0] = 255;
+                diff[1] = 0;
+                diff[2] = 0;
+            }
+            else
+            {
+                for (int c = 0; c < 3; ++c)
+                    diff[c] = expected[c] / 4;
+            }
+        }
+    }
+
+    result.mismatch_ratio = static_cast<double>(result.mismatched_pixels) /
+                            (static_cast<double>(reference.width) * static_cast<double>(reference.height));
+    return result;
+}
+} // namespace cgr
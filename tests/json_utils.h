@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+
+namespace cgr {
+
+// Minimal helpers for the flat JSON files written by the tests themselves (golden metadata, perf reports). Lookups
+// return the first occurrence of a key, so keys have to be unique within a file.
+
+inline std::string EscapeJson(const std::string& text)
+{
+    std::string escaped;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+
+inline std::optional<std::string> ReadTextFile(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+        return std::nullopt;
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+
+inline std::optional<size_t> FindJsonValue(const std::string& json, const std::string& key)
+{
+    const std::string quoted_key = '"' + key + '"';
+
+    // skip occurrences of the key that are string values rather than object keys
+    for (size_t pos = json.find(quoted_key); pos != std::string::npos; pos = json.find(quoted_key, pos + 1))
+    {
+        size_t colon = json.find_first_not_of(" \t\r\n", pos + quoted_key.size());
+        if (colon == std::string::npos || json[colon] != ':')
+            continue;
+
+        size_t value = json.find_first_not_of(" \t\r\n", colon + 1);
+        if (value != std::string::npos)
+            return value;
+    }
+    return std::nullopt;
+}
+
+
+inline std::optional<double> FindJsonNumber(const std::string& json, const std::string& key)
+{
+    auto pos = FindJsonValue(json, key);
+    if (!pos)
+        return std::nullopt;
+
+    const char* begin = json.c_str() + *pos;
+    char*       end   = nullptr;
+    double      value = std::strtod(begin, &end);
+    if (end == begin)
+        return std::nullopt;
+    return value;
+}
+
+
+inline std::optional<std::string> FindJsonString(const std::string& json, const std::string& key)
+{
+    auto pos = FindJsonValue(json, key);
+    if (!pos || json[*pos] != '"')
+        return std::nullopt;
+
+    std::string value;
+    for (size_t i = *pos + 1; i < json.size(); ++i)
+    {
+        if (json[i] == '\\' && i + 1 < json.size())
+            value += json[++i];
+        else if (json[i] == '"')
+            return value;
+        else
+            value += json[i];
+    }
+    return std::nullopt;
+}
+} // namespace cgr
@@ -0,0 +1,124 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "cgr_error.h"
+#include "json_utils.h"
+
+namespace cgr {
+
+struct FrameTimeStats
+{
+    double mean_ms   = 0.0;
+    double median_ms = 0.0;
+    double p95_ms    = 0.0;
+    double min_ms    = 0.0;
+    double max_ms    = 0.0;
+
+    static FrameTimeStats FromSamples(std::vector<double> samples_ms)
+    {
+        FrameTimeStats stats;
+        if (samples_ms.empty())
+            return stats;
+
+        std::sort(samples_ms.begin(), samples_ms.end());
+
+        auto percentile = [&samples_ms](double p) {
+            const size_t index = static_cast<size_t>(std::ceil(p * static_cast<double>(samples_ms.size()))) - 1;
+            return samples_ms[std::min(index, samples_ms.size() - 1)];
+        };
+
+        stats.mean_ms   = std::accumulate(samples_ms.begin(), samples_ms.end(), 0.0) / samples_ms.size();
+        stats.median_ms = percentile(0.5);
+        stats.p95_ms    = percentile(0.95);
+        stats.min_ms    = samples_ms.front();
+        stats.max_ms    = samples_ms.back();
+        return stats;
+    }
+};
+
+struct PerfThreshold
+{
+    std::string metric;
+    double      limit = 0.0;
+    double      value = 0.0;
+    bool        upper = true; // true: value must not exceed limit, false: value must reach limit
+
+    bool Passed() const { return upper ? value <= limit : value >= limit; }
+};
+
+struct PerfReport
+{
+    std::string                scene;
+    std::string                adapter;
+    std::string                baseline;
+    uint32_t                   width          = 0;
+    uint32_t                   height         = 0;
+    uint32_t                   frames         = 0;
+    FrameTimeStats             frame_time     = {};
+    double                     throughput_fps = 0.0;
+    std::vector<PerfThreshold> thresholds     = {};
+
+    bool Passed() const
+    {
+        return std::all_of(thresholds.begin(), thresholds.end(), [](const PerfThreshold& t) { return t.Passed(); });
+    }
+
+    // Adds thresholds that fail if a metric is more than max_regression_percent worse than in the baseline report.
+    // Returns the adapter the baseline was measured on.
+    std::string AddBaselineThresholds(const std::string& baseline_json, double max_regression_percent)
+    {
+        const auto baseline_mean = FindJsonNumber(baseline_json, "mean");
+        const auto baseline_p95  = FindJsonNumber(baseline_json, "p95");
+        const auto baseline_fps  = FindJsonNumber(baseline_json, "throughput_fps");
+        if (!baseline_mean || !baseline_p95 || !baseline_fps)
+            throw CGR_FAIL("Performance baseline is missing one of 'mean', 'p95' or 'throughput_fps'!");
+
+        const double factor = 1.0 + max_regression_percent / 100.0;
+        thresholds.push_back({ "frame_time_ms.mean", *baseline_mean * factor, frame_time.mean_ms, true });
+        thresholds.push_back({ "frame_time_ms.p95", *baseline_p95 * factor, frame_time.p95_ms, true });
+        thresholds.push_back({ "throughput_fps", *baseline_fps / factor, throughput_fps, false });
+
+        return FindJsonString(baseline_json, "adapter").value_or("unknown adapter");
+    }
+
+    void WriteJson(const std::string& path) const
+    {
+        std::ofstream file(path);
+        if (!file)
+            throw CGR_FAIL("Could not write performance report '" + path + "'!");
+
+        file << "{\n";
+        file << "  \"scene\": \"" << scene << "\",\n";
+        file << "  \"adapter\": \"" << EscapeJson(adapter) << "\",\n";
+        file << "  \"baseline\": \"" << EscapeJson(baseline) << "\",\n";
+        file << "  \"width\": " << width << ",\n";
+        file << "  \"height\": " << height << ",\n";
+        file << "  \"frames\": " << frames << ",\n";
+        file << "  \"frame_time_ms\": {\n";
+        file << "    \"mean\": " << frame_time.mean_ms << ",\n";
+        file << "    \"median\": " << frame_time.median_ms << ",\n";
+        file << "    \"p95\": " << frame_time.p95_ms << ",\n";
+        file << "    \"min\": " << frame_time.min_ms << ",\n";
+        file << "    \"max\": " << frame_time.max_ms << "\n";
+        file << "  },\n";
+        file << "  \"throughput_fps\": " << throughput_fps << ",\n";
+        file << "  \"thresholds\": [\n";
+        for (size_t i = 0; i < thresholds.size(); ++i)
+        {
+            const auto& t = thresholds[i];
+            file << "    { \"metric\": \"" << t.metric << "\", \"limit\": " << t.limit << ", \"value\": " << t.value
+                 << ", \"kind\": \"" << (t.upper ? "max" : "min") << "\", \"passed\": "
+                 << (t.Passed() ? "true" : "false") << " }" << (i + 1 < thresholds.size() ? "," : "") << "\n";
+        }
+        file << "  ],\n";
+        file << "  \"passed\": " << (Passed() ? "true" : "false") << "\n";
+        file << "}\n";
+    }
+};
+} // namespace cgr
@@ -0,0 +1,396 @@
+// Headless render regression and performance tests.
+//
+//   Hello-Diligent-Tests image <scene> --golden-dir <dir> --output-dir <dir> [--tolerance <n>]
+//                        [--max-mismatch <ratio>] [--update-golden] [--require-software-adapter]
+//                        [--require-references]
+//   Hello-Diligent-Tests perf <scene> --output-dir <dir> [--frames <n>] [--warmup <n>]
+//                        [--baseline <file>] [--max-regression <percent>] [--update-baseline]
+//                        [--max-mean-ms <ms>] [--max-p95-ms <ms>] [--min-fps <fps>] [--require-software-adapter]
+//                        [--require-references]
+//
+// Both modes render the cube into offscreen targets using the same render path as the application, preferring a
+// software Vulkan adapter so results are reproducible on CPU-only machines. With --require-software-adapter the run
+// fails instead of falling back to a hardware adapter. The perf test compares against a baseline report measured on
+// the same machine, allowing max-regression percent before it fails. The process exit code is the test result; a
+// missing golden image or baseline exits with kSkipReturnCode, or fails with --require-references.
+
+#include <g3log/g3log.hpp>
+#include <g3log/logworker.hpp>
+#include "StandardOutSink.h"
+#include "cgr_error.h"
+#include "hello.h"
+#include "image_compare.h"
+#include "json_utils.h"
+#include "perf_report.h"
+
+#include <MapHelper.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+constexpr Diligent::Uint32 kTestWidth  = 256;
+constexpr Diligent::Uint32 kTestHeight = 256;
+
+// reported to ctest through SKIP_RETURN_CODE when a reference file is missing, so it is not mistaken for a failure
+constexpr int kSkipReturnCode = 77;
+
+struct Scene
+{
+    HelloDiligent::TimeValueType start_time = 0; // animation time of the first frame in microseconds
+    HelloDiligent::TimeValueType frame_time = 0; // animation time step per frame in microseconds
+};
+
+// clang-format off
+static const std::map<std::string, Scene> kScenes = {
+    { "cube_initial",  { 0,       0     } },
+    { "cube_rotated",  { 1000000, 0     } },
+    { "cube_spinning", { 0,       16667 } },
+};
+// clang-format on
+
+
+struct Options
+{
+    std::string mode;
+    std::string scene;
+    std::string golden_dir     = ".";
+    std::string output_dir     = ".";
+    std::string baseline       = "";
+    bool        update         = false; // rewrite the golden image or baseline instead of comparing
+    bool        software       = false; // require a software adapter
+    bool        references     = false; // fail instead of skip when a golden image or baseline is missing
+    uint32_t    tolerance      = 2;
+    double      max_mismatch   = 0.001;
+    uint32_t    frames         = 200;
+    uint32_t    warmup         = 10;
+    double      max_regression = 10.0; // percent, relative to the baseline
+    double      max_mean_ms    = 0.0;  // absolute thresholds <= 0 are disabled
+    double      max_p95_ms     = 0.0;
+    double      min_fps        = 0.0;
+};
+
+
+static Options ParseOptions(int argc, char* argv[])
+{
+    if (argc < 3)
+        throw CGR_FAIL("Usage: Hello-Diligent-Tests <image|perf> <scene> [options]");
+
+    Options options;
+    options.mode  = argv[1];
+    options.scene = argv[2];
+
+    for (int i = 3; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--update-golden" || arg == "--update-baseline")
+        {
+            // each update flag only belongs to one mode, so a mix-up never overwrites the other reference
+            const char* expected_mode = arg == "--update-golden" ? "image" : "perf";
+            if (options.mode != expected_mode)
+                throw CGR_FAIL("Option '" + arg + "' is only valid in " + expected_mode + " mode!");
+
+            options.update = true;
+            continue;
+        }
+        if (arg == "--require-software-adapter")
+        {
+            options.software = true;
+            continue;
+        }
+        if (arg == "--require-references")
+        {
+            options.references = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+            throw CGR_FAIL("Missing value for option '" + arg + "'!");
+        const std::string value = argv[++i];
+
+        if (arg == "--golden-dir")
+            options.golden_dir = value;
+        else if (arg == "--output-dir")
+            options.output_dir = value;
+        else if (arg == "--tolerance")
+            options.tolerance = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--max-mismatch")
+            options.max_mismatch = std::stod(value);
+        else if (arg == "--frames")
+            options.frames = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--warmup")
+            options.warmup = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--max-mean-ms")
+            options.max_mean_ms = std::stod(value);
+        else if (arg == "--max-p95-ms")
+            options.max_p95_ms = std::stod(value);
+        else if (arg == "--min-fps")
+            options.min_fps = std::stod(value);
+        else if (arg == "--baseline")
+            options.baseline = value;
+        else if (arg == "--max-regression")
+            options.max_regression = std::stod(value);
+        else
+            throw CGR_FAIL("Unknown option '" + arg + "'!");
+    }
+
+    if (kScenes.find(options.scene) == kScenes.end())
+        throw CGR_FAIL("Unknown scene '" + options.scene + "'!");
+
+    // without samples every frame time threshold would pass trivially
+    if (options.frames == 0)
+        throw CGR_FAIL("Option '--frames' must be greater than 0!");
+
+    return options;
+}
+
+
+static cgr::Image ReadBackColorBuffer(HelloDiligent& app)
+{
+    const auto& color_desc = app.offscreen_color_->GetDesc();
+
+    Diligent::TextureDesc staging_desc = color_desc;
+    staging_desc.Name           = "Readback staging texture";
+    staging_desc.Usage          = Diligent::USAGE_STAGING;
+    staging_desc.BindFlags      = Diligent::BIND_NONE;
+    staging_desc.CPUAccessFlags = Diligent::CPU_ACCESS_READ;
+
+    Diligent::RefCntAutoPtr<Diligent::ITexture> staging_texture;
+    app.device_->CreateTexture(staging_desc, nullptr, &staging_texture);
+    if (staging_texture == nullptr)
+        throw CGR_FAIL("Could not create readback staging texture!");
+
+    Diligent::CopyTextureAttribs copy_attribs(app.offscreen_color_, Diligent::RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                                              staging_texture, Diligent::RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    app.device_context_->CopyTexture(copy_attribs);
+    app.device_context_->WaitForIdle();
+
+    Diligent::MappedTextureSubresource mapped;
+    app.device_context_->MapTextureSubresource(staging_texture, 0, 0, Diligent::MAP_READ, Diligent::MAP_FLAG_NONE,
+                                               nullptr, mapped);
+    if (mapped.pData == nullptr)
+        throw CGR_FAIL("Could not map readback staging texture!");
+
+    // the color buffer is RGBA8, the alpha channel is dropped
+    cgr::Image image(color_desc.Width, color_desc.Height);
+    for (Diligent::Uint32 y = 0; y < color_desc.Height; ++y)
+    {
+        const auto* row = static_cast<const uint8_t*>(mapped.pData) + y * mapped.Stride;
+        for (Diligent::Uint32 x = 0; x < color_desc.Width; ++x)
+        {
+            uint8_t* pixel = image.At(x, y);
+            pixel[0]       = row[x * 4 + 0];
+            pixel[1]       = row[x * 4 + 1];
+            pixel[2]       = row[x * 4 + 2];
+        }
+    }
+
+    app.device_context_->UnmapTextureSubresource(staging_texture, 0, 0);
+    return image;
+}
+
+
+static void WriteGoldenMetadata(const std::string& path, const std::string& scene, const std::string& adapter)
+{
+    std::ofstream file(path);
+    if (!file)
+        throw CGR_FAIL("Could not write golden metadata '" + path + "'!");
+
+    file << "{\n";
+    file << "  \"scene\": \"" << scene << "\",\n";
+    file << "  \"adapter\": \"" << cgr::EscapeJson(adapter) << "\",\n";
+    file << "  \"width\": " << kTestWidth << ",\n";
+    file << "  \"height\": " << kTestHeight << "\n";
+    file << "}\n";
+}
+
+
+static int RunImageTest(HelloDiligent& app, const Options& options)
+{
+    const Scene&      scene   = kScenes.at(options.scene);
+    const std::string adapter = app.device_->GetAdapterInfo().Description;
+
+    app.Update(scene.start_time, scene.frame_time);
+    app.DrawOffscreen();
+    cgr::Image actual = ReadBackColorBuffer(app);
+
+    const std::string golden_path   = options.golden_dir + "/" + options.scene + ".ppm";
+    const std::string metadata_path = options.golden_dir + "/" + options.scene + ".golden.json";
+    if (options.update)
+    {
+        cgr::WritePPM(golden_path, actual);
+        WriteGoldenMetadata(metadata_path, options.scene, adapter);
+        LOG(INFO) << "Updated golden image " << golden_path << " rendered on " << adapter;
+        return EXIT_SUCCESS;
+    }
+
+    cgr::WritePPM(options.output_dir + "/" + options.scene + ".actual.ppm", actual);
+
+    if (!std::ifstream(golden_path))
+    {
+        LOG(WARNING) << "Golden image " << golden_path << " does not exist, "
+                     << (options.references ? "failing " : "skipping ") << options.scene;
+        return options.references ? EXIT_FAILURE : kSkipReturnCode;
+    }
+
+    std::string golden_adapter = "unknown adapter";
+    if (auto metadata = cgr::ReadTextFile(metadata_path))
+        golden_adapter = cgr::FindJsonString(*metadata, "adapter").value_or(golden_adapter);
+    if (golden_adapter != adapter)
+        LOG(WARNING) << "Golden image was rendered on " << golden_adapter << ", this run uses " << adapter;
+
+    cgr::Image reference = cgr::ReadPPM(golden_path);
+    auto       result    = cgr::CompareImages(reference, actual, options.tolerance);
+
+    LOG(INFO) << options.scene << ": " << result.mismatched_pixels << " mismatched pixels ("
+              << result.mismatch_ratio * 100.0 << "%), max channel delta " << result.max_channel_delta;
+
+    if (result.mismatch_ratio > options.max_mismatch)
+    {
+        cgr::WritePPM(options.output_dir + "/" + options.scene + ".diff.ppm", result.diff);
+        LOG(WARNING) << options.scene << ": mismatch ratio exceeds " << options.max_mismatch * 100.0
+                     << "% (golden: " << golden_adapter << ", actual: " << adapter << ")";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+
+static int RunPerfTest(HelloDiligent& app, const Options& options)
+{
+    using Clock = std::chrono::steady_clock; // monotonic, high_resolution_clock may follow wall clock adjustments
+    using Ms    = std::chrono::duration<double, std::milli>;
+
+    const Scene&                 scene = kScenes.at(options.scene);
+    HelloDiligent::TimeValueType time  = scene.start_time;
+
+    auto render_frame = [&]() {
+        app.Update(time, scene.frame_time);
+        app.DrawOffscreen();
+        time += scene.frame_time;
+    };
+
+    for (uint32_t i = 0; i < options.warmup; ++i)
+        render_frame();
+    app.device_context_->WaitForIdle();
+
+    // frame time: each frame waits for the GPU, so this measures the full CPU + GPU latency of one frame
+    std::vector<double> frame_times_ms;
+    frame_times_ms.reserve(options.frames);
+    for (uint32_t i = 0; i < options.frames; ++i)
+    {
+        const auto start = Clock::now();
+        render_frame();
+        app.device_context_->WaitForIdle();
+        frame_times_ms.push_back(Ms(Clock::now() - start).count());
+    }
+
+    // throughput: frames are queued back to back and only the final frame is waited for
+    const auto throughput_start = Clock::now();
+    for (uint32_t i = 0; i < options.frames; ++i)
+        render_frame();
+    app.device_context_->WaitForIdle();
+    const double throughput_ms = Ms(Clock::now() - throughput_start).count();
+
+    cgr::PerfReport report;
+    report.scene          = options.scene;
+    report.adapter        = app.device_->GetAdapterInfo().Description;
+    report.width          = kTestWidth;
+    report.height         = kTestHeight;
+    report.frames         = options.frames;
+    report.frame_time     = cgr::FrameTimeStats::FromSamples(frame_times_ms);
+    report.throughput_fps = throughput_ms > 0.0 ? options.frames * 1000.0 / throughput_ms : 0.0;
+
+    if (options.max_mean_ms > 0.0)
+        report.thresholds.push_back({ "frame_time_ms.mean", options.max_mean_ms, report.frame_time.mean_ms, true });
+    if (options.max_p95_ms > 0.0)
+        report.thresholds.push_back({ "frame_time_ms.p95", options.max_p95_ms, report.frame_time.p95_ms, true });
+    if (options.min_fps > 0.0)
+        report.thresholds.push_back({ "throughput_fps", options.min_fps, report.throughput_fps, false });
+
+    const std::string report_path = options.output_dir + "/" + options.scene + ".perf.json";
+
+    if (options.update)
+    {
+        if (options.baseline.empty())
+            throw CGR_FAIL("Option '--update-baseline' requires '--baseline'!");
+
+        report.WriteJson(options.baseline);
+        LOG(INFO) << "Updated performance baseline " << options.baseline << " measured on " << report.adapter;
+        return EXIT_SUCCESS;
+    }
+
+    bool skipped = false;
+    if (!options.baseline.empty())
+    {
+        report.baseline = options.baseline;
+        if (auto baseline_json = cgr::ReadTextFile(options.baseline))
+        {
+            const std::string baseline_adapter = report.AddBaselineThresholds(*baseline_json, options.max_regression);
+            if (baseline_adapter != report.adapter)
+                LOG(WARNING) << "Baseline was measured on " << baseline_adapter << ", this run uses " << report.adapter;
+        }
+        else
+        {
+            LOG(WARNING) << "Performance baseline " << options.baseline << " does not exist, "
+                         << (options.references ? "failing" : "skipping regression check");
+            if (options.references)
+                return EXIT_FAILURE;
+            skipped = true;
+        }
+    }
+
+    report.WriteJson(report_path);
+
+    LOG(INFO) << options.scene << ": mean " << report.frame_time.mean_ms << " ms, p95 " << report.frame_time.p95_ms
+              << " ms, throughput " << report.throughput_fps << " fps (" << report_path << ")";
+
+    for (const auto& threshold : report.thresholds)
+    {
+        if (!threshold.Passed())
+            LOG(WARNING) << threshold.metric << " = " << threshold.value << " violates "
+                         << (threshold.upper ? "max " : "min ") << threshold.limit;
+    }
+
+    if (skipped && report.Passed())
+        return kSkipReturnCode;
+    return report.Passed() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+int main(int argc, char* argv[])
+{
+    auto logWorker = g3::LogWorker::createLogWorker();
+    g3::initializeLogging(logWorker.get());
+
+    auto stdOutHandle = logWorker->addSink(std::make_unique<cgr::StandardOutSink>(g3::kInfoValue),
+                                           &cgr::StandardOutSink::ReceiveLogMessage);
+
+    try
+    {
+        const Options options = ParseOptions(argc, argv);
+
+        HelloDiligent app;
+        app.InitDiligentHeadless(kTestWidth, kTestHeight, options.software);
+        app.Initialize();
+
+        if (options.mode == "image")
+            return RunImageTest(app, options);
+        if (options.mode == "perf")
+            return RunPerfTest(app, options);
+
+        throw CGR_FAIL("Unknown test mode '" + options.mode + "'!");
+    }
+    catch (const cgrebel::Error& e)
+    {
+        LogCapture(e.file.c_str(), e.line, e.function.c_str(), WARNING).stream() << e.what();
+        return EXIT_FAILURE;
+    }
+    catch (const std::exception& e)
+    {
+        LOG(WARNING) << e.what();
+        return EXIT_FAILURE;
+    }
+}